@@ -1,7 +1,20 @@
 #include <math.h>
 #include <stdio.h>
 
-int main() {
+#include "batch_io.h"
+#include "simplemath.h"
+
+// Batch kernel: area of a circle for every radius
+static size_t area_kernel(double* out, const double* in, size_t n) {
+    area_batch(out, in, n);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return batch_main(argc, argv, "area", area_kernel);
+    }
+
     double radius, area;
 
     printf("Enter the radius of the circle: ");
@@ -0,0 +1,525 @@
+#include "batch_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Values per kernel call; large enough that simplemath's thread split
+// (MIN_PER_THREAD = 32K elements per thread) can use up to eight threads
+#define CHUNK_VALUES (256 * 1024)
+#define READ_BUF_SIZE (1024 * 1024)  // bytes per read() from stdin
+#define WRITE_BUF_SIZE (1024 * 1024) // bytes buffered before each write
+#define MAX_TOKEN_LEN 64             // tokens longer than this use a heap copy
+
+typedef struct BatchContext {
+    const char* name;
+    batch_kernel_fn kernel;
+    double* in;       // parsed values waiting for the kernel
+    double* out;      // kernel results
+    size_t count;     // values currently in `in`
+    size_t total;     // values processed so far
+    size_t errors;    // domain errors reported by the kernel
+    int binary_out;
+    char* wbuf;       // output buffer
+    size_t wlen;
+} BatchContext;
+
+// Exact powers of ten representable as doubles (Clinger's fast path)
+static const double pow10_table[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static void print_usage(const char* name) {
+    fprintf(stderr, "Usage: %s.out                 (interactive)\n", name);
+    fprintf(stderr,
+            "       %s.out --batch [--binary] [--binary-out] [FILE]\n", name);
+    fprintf(stderr, "  --binary      Read raw float64 values instead of text\n");
+    fprintf(stderr, "  --binary-out  Write raw float64 results instead of text\n");
+    fprintf(stderr, "  FILE          Input file (memory-mapped); stdin if omitted or -\n");
+}
+
+static int is_delim(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',' ||
+           c == '\f' || c == '\v';
+}
+
+/**
+ * Slow path for tokens the fast parser cannot convert exactly
+ * (long mantissas, large exponents, inf/nan, hex floats)
+ */
+static int parse_number_slow(const char* start, const char* end, double* value) {
+    const char* p = start;
+    while (p < end && !is_delim(*p)) {
+        p++;
+    }
+
+    size_t len = (size_t)(p - start);
+    if (len == 0) {
+        return -1;
+    }
+
+    // strtod needs a NUL-terminated copy; tokens that do not fit the stack
+    // buffer (e.g. long exact decimal expansions) are copied to the heap
+    char stack_token[MAX_TOKEN_LEN];
+    char* token = stack_token;
+    if (len >= MAX_TOKEN_LEN) {
+        token = (char*)malloc(len + 1);
+        if (!token) {
+            return -1;
+        }
+    }
+    memcpy(token, start, len);
+    token[len] = '\0';
+
+    char* parse_end;
+    *value = strtod(token, &parse_end);
+    int rc = parse_end == token + len ? 0 : -1;
+    if (token != stack_token) {
+        free(token);
+    }
+    return rc;
+}
+
+/**
+ * Parse one decimal number starting at *pp
+ * @param pp Cursor, advanced past the number on success
+ * @param end End of the input buffer (input need not be NUL-terminated)
+ * @param value Parsed value
+ * @return 0 on success, -1 if the token is not a number
+ */
+static int parse_number(const char** pp, const char* end, double* value) {
+    const char* start = *pp;
+    const char* p = start;
+    int negative = 0;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;      // significant digits accumulated in mantissa
+    int exp10 = 0;
+    int seen_digit = 0;
+    int truncated = 0;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        seen_digit = 1;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits += mantissa != 0;
+        }
+        else {
+            exp10++;
+            truncated = 1;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            seen_digit = 1;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits += mantissa != 0;
+                exp10--;
+            }
+            else {
+                truncated = 1;
+            }
+        }
+    }
+
+    if (!seen_digit) {
+        goto slow;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        int exp_negative = 0;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = *p == '-';
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            goto slow;
+        }
+        int exponent = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+        }
+        exp10 += exp_negative ? -exponent : exponent;
+    }
+
+    if (p < end && !is_delim(*p)) {
+        goto slow;
+    }
+
+    // A mantissa below 2^53 and |exp10| <= 22 are both exact, so a single
+    // multiply or divide gives the correctly rounded result
+    if (!truncated && mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = (double)mantissa;
+        v = exp10 < 0 ? v / pow10_table[-exp10] : v * pow10_table[exp10];
+        *value = negative ? -v : v;
+        *pp = p;
+        return 0;
+    }
+
+slow:
+    if (parse_number_slow(start, end, value) != 0) {
+        return -1;
+    }
+    while (*pp < end && !is_delim(**pp)) {
+        (*pp)++;
+    }
+    return 0;
+}
+
+static int write_all(const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int flush_output(BatchContext* ctx) {
+    if (ctx->wlen > 0 && write_all(ctx->wbuf, ctx->wlen) != 0) {
+        fprintf(stderr, "%s: write error: %s\n", ctx->name, strerror(errno));
+        return -1;
+    }
+    ctx->wlen = 0;
+    return 0;
+}
+
+static int write_results(BatchContext* ctx, const double* results, size_t n) {
+    if (ctx->binary_out) {
+        const char* bytes = (const char*)results;
+        size_t len = n * sizeof(double);
+        while (len > 0) {
+            size_t room = WRITE_BUF_SIZE - ctx->wlen;
+            size_t take = len < room ? len : room;
+            memcpy(ctx->wbuf + ctx->wlen, bytes, take);
+            ctx->wlen += take;
+            bytes += take;
+            len -= take;
+            if (ctx->wlen == WRITE_BUF_SIZE && flush_output(ctx) != 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        // "%.17g" round-trips every double and never exceeds 25 bytes
+        if (WRITE_BUF_SIZE - ctx->wlen < 32 && flush_output(ctx) != 0) {
+            return -1;
+        }
+        ctx->wlen += (size_t)snprintf(ctx->wbuf + ctx->wlen,
+                                      WRITE_BUF_SIZE - ctx->wlen, "%.17g\n",
+                                      results[i]);
+    }
+    return 0;
+}
+
+// Run the kernel over `in` and write the results
+static int process_values(BatchContext* ctx, const double* in, size_t n) {
+    ctx->errors += ctx->kernel(ctx->out, in, n);
+    ctx->total += n;
+    return write_results(ctx, ctx->out, n);
+}
+
+static int flush_values(BatchContext* ctx) {
+    int rc = process_values(ctx, ctx->in, ctx->count);
+    ctx->count = 0;
+    return rc;
+}
+
+// Parse every complete token in [p, end) and feed the values to the kernel
+static int parse_text(BatchContext* ctx, const char* p, const char* end) {
+    for (;;) {
+        while (p < end && is_delim(*p)) {
+            p++;
+        }
+        if (p == end) {
+            return 0;
+        }
+        if (ctx->count == CHUNK_VALUES && flush_values(ctx) != 0) {
+            return -1;
+        }
+        if (parse_number(&p, end, &ctx->in[ctx->count]) != 0) {
+            fprintf(stderr, "%s: invalid number at value %zu\n", ctx->name,
+                    ctx->total + ctx->count + 1);
+            return -1;
+        }
+        ctx->count++;
+    }
+}
+
+static int process_mapped(BatchContext* ctx, const char* data, size_t size,
+                          int binary) {
+    if (!binary) {
+        return parse_text(ctx, data, data + size);
+    }
+
+    if (size % sizeof(double) != 0) {
+        fprintf(stderr, "%s: binary input size is not a multiple of %zu bytes\n",
+                ctx->name, sizeof(double));
+        return -1;
+    }
+
+    // Values can be used in place when the start offset keeps them aligned
+    // (always true for a file mapped from the beginning); otherwise each
+    // chunk is copied into the input buffer first
+    int aligned = (uintptr_t)data % sizeof(double) == 0;
+    const double* values = (const double*)(const void*)data;
+    size_t n = size / sizeof(double);
+    for (size_t i = 0; i < n; i += CHUNK_VALUES) {
+        size_t len = n - i < CHUNK_VALUES ? n - i : CHUNK_VALUES;
+        const double* chunk = values + i;
+        if (!aligned) {
+            memcpy(ctx->in, data + i * sizeof(double), len * sizeof(double));
+            chunk = ctx->in;
+        }
+        if (process_values(ctx, chunk, len) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Map and process a regular file from its current offset to the end
+ * Redirected stdin may already be partly consumed (e.g. a header read by the
+ * shell), so the mapping starts at the page containing the current offset
+ * and the descriptor is left positioned at end of file, as read() would.
+ */
+static int process_fd_mapped(BatchContext* ctx, int fd, size_t size, int binary) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0) {
+        offset = 0;
+    }
+    if ((size_t)offset >= size) {
+        return 0;
+    }
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    off_t map_offset = page_size > 0 ? offset - offset % page_size : 0;
+    size_t skip = (size_t)(offset - map_offset);
+    size_t map_size = size - (size_t)map_offset;
+
+    void* data = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, map_offset);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "%s: mmap failed: %s\n", ctx->name, strerror(errno));
+        return -1;
+    }
+    madvise(data, map_size, MADV_SEQUENTIAL);
+
+    int rc = process_mapped(ctx, (const char*)data + skip, map_size - skip,
+                            binary);
+    munmap(data, map_size);
+    lseek(fd, (off_t)size, SEEK_SET);
+    return rc;
+}
+
+static ssize_t read_some(int fd, char* buf, size_t len) {
+    for (;;) {
+        ssize_t n = read(fd, buf, len);
+        if (n >= 0 || errno != EINTR) {
+            return n;
+        }
+    }
+}
+
+// Stream a pipe in READ_BUF_SIZE chunks, carrying partial tokens over
+static int process_stream(BatchContext* ctx, int fd, int binary) {
+    char* buf = (char*)malloc(READ_BUF_SIZE);
+    if (!buf) {
+        fprintf(stderr, "%s: failed to allocate read buffer\n", ctx->name);
+        return -1;
+    }
+
+    size_t len = 0;
+    int rc = 0;
+    for (;;) {
+        ssize_t n = read_some(fd, buf + len, READ_BUF_SIZE - len);
+        if (n < 0) {
+            fprintf(stderr, "%s: read error: %s\n", ctx->name, strerror(errno));
+            rc = -1;
+            break;
+        }
+        if (n == 0) {
+            if (binary) {
+                if (len != 0) {
+                    fprintf(stderr, "%s: %zu trailing bytes in binary input\n",
+                            ctx->name, len);
+                    rc = -1;
+                }
+            }
+            else {
+                rc = parse_text(ctx, buf, buf + len);
+            }
+            break;
+        }
+        len += (size_t)n;
+
+        size_t cut;
+        if (binary) {
+            cut = len - len % sizeof(double);
+            size_t values = cut / sizeof(double);
+            for (size_t i = 0; i < values; i += CHUNK_VALUES) {
+                size_t take = values - i < CHUNK_VALUES ? values - i : CHUNK_VALUES;
+                memcpy(ctx->in, buf + i * sizeof(double), take * sizeof(double));
+                if (process_values(ctx, ctx->in, take) != 0) {
+                    rc = -1;
+                    break;
+                }
+            }
+        }
+        else {
+            // Only parse up to the last delimiter; the tail may be a number
+            // split across two reads
+            cut = len;
+            while (cut > 0 && !is_delim(buf[cut - 1])) {
+                cut--;
+            }
+            if (cut == 0 && len == READ_BUF_SIZE) {
+                fprintf(stderr, "%s: token too long in input\n", ctx->name);
+                rc = -1;
+            }
+            else if (cut > 0) {
+                rc = parse_text(ctx, buf, buf + cut);
+            }
+        }
+        if (rc != 0) {
+            break;
+        }
+
+        memmove(buf, buf + cut, len - cut);
+        len -= cut;
+    }
+
+    free(buf);
+    return rc;
+}
+
+static int process_input(BatchContext* ctx, const char* path, int binary) {
+    int fd = STDIN_FILENO;
+    if (path && strcmp(path, "-") != 0) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "%s: cannot open %s: %s\n", ctx->name, path,
+                    strerror(errno));
+            return -1;
+        }
+    }
+
+    // Regular files (including redirected stdin) are mapped; pipes are streamed
+    struct stat st;
+    int rc;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        rc = process_fd_mapped(ctx, fd, (size_t)st.st_size, binary);
+    }
+    else {
+        rc = process_stream(ctx, fd, binary);
+    }
+
+    if (rc == 0 && ctx->count > 0) {
+        rc = flush_values(ctx);
+    }
+
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return rc;
+}
+
+int batch_main(int argc, char** argv, const char* name, batch_kernel_fn kernel) {
+    const char* path = NULL;
+    int batch = 0;
+    int binary = 0;
+    int binary_out = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--batch") == 0 || strcmp(argv[i], "-b") == 0) {
+            batch = 1;
+        }
+        else if (strcmp(argv[i], "--binary") == 0) {
+            binary = 1;
+        }
+        else if (strcmp(argv[i], "--binary-out") == 0) {
+            binary_out = 1;
+        }
+        else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(name);
+            return 0;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "%s: unknown option %s\n", name, argv[i]);
+            print_usage(name);
+            return 2;
+        }
+        else if (!path) {
+            path = argv[i];
+        }
+        else {
+            fprintf(stderr, "%s: only one input file is supported\n", name);
+            return 2;
+        }
+    }
+
+    if (!batch) {
+        print_usage(name);
+        return 2;
+    }
+
+    BatchContext ctx = {0};
+    ctx.name = name;
+    ctx.kernel = kernel;
+    ctx.binary_out = binary_out;
+    ctx.in = (double*)malloc(CHUNK_VALUES * sizeof(double));
+    ctx.out = (double*)malloc(CHUNK_VALUES * sizeof(double));
+    ctx.wbuf = (char*)malloc(WRITE_BUF_SIZE);
+    if (!ctx.in || !ctx.out || !ctx.wbuf) {
+        fprintf(stderr, "%s: failed to allocate batch buffers\n", name);
+        free(ctx.in);
+        free(ctx.out);
+        free(ctx.wbuf);
+        return 1;
+    }
+
+    int rc = process_input(&ctx, path, binary);
+    if (flush_output(&ctx) != 0) {
+        rc = -1;
+    }
+
+    free(ctx.in);
+    free(ctx.out);
+    free(ctx.wbuf);
+
+    if (rc != 0) {
+        return 1;
+    }
+    if (ctx.errors > 0) {
+        fprintf(stderr, "%s: %zu of %zu values were outside the domain\n", name,
+                ctx.errors, ctx.total);
+        return 1;
+    }
+    return 0;
+}
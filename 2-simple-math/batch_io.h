@@ -0,0 +1,33 @@
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include <stddef.h>
+
+/**
+ * Kernel applied to every chunk of parsed input values
+ * @param out Output array (n elements)
+ * @param in Input array (n elements)
+ * @param n Number of elements in the chunk
+ * @return Number of elements outside the function's domain
+ */
+typedef size_t (*batch_kernel_fn)(double* out, const double* in, size_t n);
+
+/**
+ * Run a program in streaming batch mode
+ *
+ * Usage: <name>.out --batch [--binary] [--binary-out] [FILE]
+ *
+ * Values are read from FILE (memory-mapped) or from stdin when FILE is
+ * omitted or "-". Text input is any whitespace- or comma-separated list of
+ * numbers; --binary reads raw native-endian float64. Results are written to
+ * stdout one per line, or as raw float64 with --binary-out.
+ *
+ * @param argc Argument count from main()
+ * @param argv Argument vector from main()
+ * @param name Program name used in messages
+ * @param kernel Function applied to each chunk of values
+ * @return Process exit status
+ */
+int batch_main(int argc, char** argv, const char* name, batch_kernel_fn kernel);
+
+#endif // BATCH_IO_H
@@ -1,7 +1,19 @@
 #include <math.h>
 #include <stdio.h>
 
-int main() {
+#include "batch_io.h"
+#include "simplemath.h"
+
+// Batch kernel: zero or negative inputs count as domain errors
+static size_t log_kernel(double* out, const double* in, size_t n) {
+    return log10_batch(out, in, n, NULL);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return batch_main(argc, argv, "log", log_kernel);
+    }
+
     double number, result;
 
     printf("Enter a number to find its logarithm (base 10): ");
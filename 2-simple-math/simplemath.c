@@ -0,0 +1,366 @@
+#include "simplemath.h"
+
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SIMPLEMATH_X86 1
+#include <immintrin.h>
+#endif
+
+// The v4df helpers are always inlined (and take vectors by pointer), so no
+// vector ever crosses a call boundary and the AVX return ABI does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+#define MAX_THREADS 64
+#define MIN_PER_THREAD (32 * 1024)  // elements; below this threads cost more than they save
+
+// Four doubles processed together; GCC lowers this to SSE2 pairs, or to
+// single AVX registers inside the target("avx2") clones below
+typedef double v4df __attribute__((vector_size(32)));
+typedef int64_t v4di __attribute__((vector_size(32)));
+
+#define V4(x) ((v4df){(x), (x), (x), (x)})
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+// Kernel over one contiguous range; returns its domain error count
+typedef size_t (*range_fn)(double* out, const double* in, size_t n,
+                           unsigned char* mask);
+
+static int max_threads = 0;
+
+void simplemath_set_num_threads(int num_threads) {
+    max_threads = num_threads > 0 ? num_threads : 0;
+}
+
+ALWAYS_INLINE v4df load_v4(const double* p) {
+    v4df v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+ALWAYS_INLINE void store_v4(double* p, const v4df* v) {
+    memcpy(p, v, sizeof(*v));
+}
+
+// Write a 0/1 flag per lane of a comparison result and count the set lanes
+ALWAYS_INLINE size_t store_mask_v4(unsigned char* mask, const v4di* bad) {
+    size_t errors = 0;
+    for (int k = 0; k < 4; k++) {
+        unsigned char flag = (*bad)[k] != 0;
+        if (mask) {
+            mask[k] = flag;
+        }
+        errors += flag;
+    }
+    return errors;
+}
+
+/* ---------------------------------------------------------------- area */
+
+ALWAYS_INLINE size_t area_range_impl(double* out, const double* in, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        v4df r = load_v4(in + i);
+        v4df area = V4(M_PI) * r * r;
+        store_v4(out + i, &area);
+    }
+    for (; i < n; i++) {
+        out[i] = M_PI * in[i] * in[i];
+    }
+    return 0;
+}
+
+static size_t area_range(double* out, const double* in, size_t n,
+                         unsigned char* mask) {
+    (void)mask;
+    return area_range_impl(out, in, n);
+}
+
+#ifdef SIMPLEMATH_X86
+__attribute__((target("avx2"))) static size_t area_range_avx2(
+    double* out, const double* in, size_t n, unsigned char* mask) {
+    (void)mask;
+    return area_range_impl(out, in, n);
+}
+#endif
+
+/* ---------------------------------------------------------------- sqrt */
+
+static size_t sqrt_tail(double* out, const double* in, size_t n,
+                        unsigned char* mask) {
+    size_t errors = 0;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char bad = in[i] < 0;
+        out[i] = sqrt(in[i]);
+        if (mask) {
+            mask[i] = bad;
+        }
+        errors += bad;
+    }
+    return errors;
+}
+
+#ifdef SIMPLEMATH_X86
+// SSE2 is part of the x86-64 baseline: two lanes per sqrtpd
+static size_t sqrt_range(double* out, const double* in, size_t n,
+                         unsigned char* mask) {
+    const __m128d zero = _mm_setzero_pd();
+    size_t errors = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(in + i);
+        _mm_storeu_pd(out + i, _mm_sqrt_pd(x));
+        int bad = _mm_movemask_pd(_mm_cmplt_pd(x, zero));
+        if (mask) {
+            mask[i] = bad & 1;
+            mask[i + 1] = (bad >> 1) & 1;
+        }
+        errors += (size_t)__builtin_popcount(bad);
+    }
+    return errors + sqrt_tail(out + i, in + i, n - i, mask ? mask + i : NULL);
+}
+
+__attribute__((target("avx2"))) static size_t sqrt_range_avx2(
+    double* out, const double* in, size_t n, unsigned char* mask) {
+    const __m256d zero = _mm256_setzero_pd();
+    size_t errors = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(in + i);
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(x));
+        int bad = _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        if (mask) {
+            for (int k = 0; k < 4; k++) {
+                mask[i + k] = (bad >> k) & 1;
+            }
+        }
+        errors += (size_t)__builtin_popcount(bad);
+    }
+    return errors + sqrt_tail(out + i, in + i, n - i, mask ? mask + i : NULL);
+}
+#else
+static size_t sqrt_range(double* out, const double* in, size_t n,
+                         unsigned char* mask) {
+    return sqrt_tail(out, in, n, mask);
+}
+#endif
+
+/* --------------------------------------------------------------- log10 */
+
+// Coefficients of the fdlibm/musl log(1+f) approximation on
+// [sqrt(2)/2, sqrt(2)), |error| < 2^-58.45
+static const double Lg1 = 6.666666666666735130e-01;
+static const double Lg2 = 3.999999999940941908e-01;
+static const double Lg3 = 2.857142874366239149e-01;
+static const double Lg4 = 2.222219843214978396e-01;
+static const double Lg5 = 1.818357216161805012e-01;
+static const double Lg6 = 1.531383769920937332e-01;
+static const double Lg7 = 1.479819860511658591e-01;
+
+// 1/ln(10) and log10(2) split into a short exact head and a tail
+static const double ivln10hi = 4.34294481878168880939e-01;
+static const double ivln10lo = 2.50829467116452752298e-11;
+static const double log10_2hi = 3.01029995663611771306e-01;
+static const double log10_2lo = 3.69423907715893078616e-13;
+
+/**
+ * log10 of four normal, positive, finite values
+ * Other lanes produce garbage and must be patched by the caller
+ */
+ALWAYS_INLINE v4df log10_v4(const v4df* x) {
+    const v4di bits = (v4di)*x;
+
+    // x = 2^k * m with m in [1, 2); the biased exponent is converted to
+    // double by planting it in the mantissa of 2^52
+    v4di exp_bits = (bits >> 52) | 0x4330000000000000LL;
+    v4df k = (v4df)exp_bits - V4(4503599627370496.0 + 1023.0);
+    v4df m = (v4df)((bits & 0x000FFFFFFFFFFFFFLL) | 0x3FF0000000000000LL);
+
+    // Move m into [sqrt(2)/2, sqrt(2)) so that f = m - 1 is small
+    v4di big = m > V4(M_SQRT2);
+    m = (v4df)(((v4di)m & ~big) | ((v4di)(m * V4(0.5)) & big));
+    k = k + (v4df)((v4di)V4(1.0) & big);
+
+    v4df f = m - V4(1.0);
+    v4df hfsq = V4(0.5) * f * f;
+    v4df s = f / (V4(2.0) + f);
+    v4df z = s * s;
+    v4df w = z * z;
+    v4df t1 = w * (V4(Lg2) + w * (V4(Lg4) + w * V4(Lg6)));
+    v4df t2 = z * (V4(Lg1) + w * (V4(Lg3) + w * (V4(Lg5) + w * V4(Lg7))));
+    v4df r = t2 + t1;
+
+    // Keep the leading bits of f - hfsq exact when scaled by 1/ln(10)
+    v4df hi = f - hfsq;
+    hi = (v4df)((v4di)hi & (int64_t)0xFFFFFFFF00000000ULL);
+    v4df lo = f - hi - hfsq + s * (hfsq + r);
+
+    v4df val_hi = hi * V4(ivln10hi);
+    v4df y = k * V4(log10_2hi);
+    v4df val_lo = k * V4(log10_2lo) + (lo + hi) * V4(ivln10lo) + lo * V4(ivln10hi);
+    v4df sum = y + val_hi;
+    val_lo = val_lo + ((y - sum) + val_hi);
+    return val_lo + sum;
+}
+
+ALWAYS_INLINE size_t log10_range_impl(double* out, const double* in, size_t n,
+                                      unsigned char* mask) {
+    size_t errors = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        v4df x = load_v4(in + i);
+        v4df result = log10_v4(&x);
+
+        // Zero, negative, subnormal, infinite and NaN lanes go through libm
+        v4di special = ~(x >= V4(DBL_MIN)) | (x == V4(INFINITY));
+        if (special[0] | special[1] | special[2] | special[3]) {
+            for (int k = 0; k < 4; k++) {
+                if (special[k]) {
+                    result[k] = log10(x[k]);
+                }
+            }
+        }
+        store_v4(out + i, &result);
+        v4di bad = x <= V4(0.0);
+        errors += store_mask_v4(mask ? mask + i : NULL, &bad);
+    }
+    for (; i < n; i++) {
+        unsigned char bad = in[i] <= 0;
+        out[i] = log10(in[i]);
+        if (mask) {
+            mask[i] = bad;
+        }
+        errors += bad;
+    }
+    return errors;
+}
+
+static size_t log10_range(double* out, const double* in, size_t n,
+                          unsigned char* mask) {
+    return log10_range_impl(out, in, n, mask);
+}
+
+#ifdef SIMPLEMATH_X86
+__attribute__((target("avx2,fma"))) static size_t log10_range_avx2(
+    double* out, const double* in, size_t n, unsigned char* mask) {
+    return log10_range_impl(out, in, n, mask);
+}
+#endif
+
+/* ------------------------------------------------------- dispatch/threads */
+
+// No cache: libgcc fills in the CPU model from a constructor before main(),
+// so each check is a read of an already-initialized global and is safe to
+// call from any number of threads
+static int cpu_has_avx2(void) {
+#ifdef SIMPLEMATH_X86
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return 0;
+#endif
+}
+
+typedef struct Job {
+    range_fn fn;
+    double* out;
+    const double* in;
+    size_t n;
+    unsigned char* mask;
+    size_t errors;
+} Job;
+
+static void* run_job(void* arg) {
+    Job* job = (Job*)arg;
+    job->errors = job->fn(job->out, job->in, job->n, job->mask);
+    return NULL;
+}
+
+static int thread_count(size_t n) {
+    int threads = max_threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    size_t useful = n / MIN_PER_THREAD;
+    if ((size_t)threads > useful) {
+        threads = useful > 0 ? (int)useful : 1;
+    }
+    return threads;
+}
+
+// Split [0, n) into cache-line aligned slices, one per thread; the calling
+// thread works on the first slice itself
+static size_t run_parallel(range_fn fn, double* out, const double* in, size_t n,
+                           unsigned char* mask) {
+    int threads = thread_count(n);
+    if (threads <= 1) {
+        return fn(out, in, n, mask);
+    }
+
+    Job jobs[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    int started[MAX_THREADS] = {0};
+    size_t per_thread = (n / (size_t)threads + 7) & ~(size_t)7;
+    size_t begin = 0;
+
+    for (int t = 0; t < threads; t++) {
+        size_t len = t == threads - 1 ? n - begin : per_thread;
+        jobs[t].fn = fn;
+        jobs[t].out = out + begin;
+        jobs[t].in = in + begin;
+        jobs[t].n = len;
+        jobs[t].mask = mask ? mask + begin : NULL;
+        jobs[t].errors = 0;
+        begin += len;
+    }
+
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&tids[t], NULL, run_job, &jobs[t]) == 0;
+    }
+
+    size_t errors = 0;
+    for (int t = 0; t < threads; t++) {
+        if (t == 0 || !started[t]) {
+            run_job(&jobs[t]);  // also covers threads that failed to start
+        }
+        else {
+            pthread_join(tids[t], NULL);
+        }
+        errors += jobs[t].errors;
+    }
+    return errors;
+}
+
+void area_batch(double* out, const double* in, size_t n) {
+#ifdef SIMPLEMATH_X86
+    run_parallel(cpu_has_avx2() ? area_range_avx2 : area_range, out, in, n, NULL);
+#else
+    run_parallel(area_range, out, in, n, NULL);
+#endif
+}
+
+size_t sqrt_batch(double* out, const double* in, size_t n, unsigned char* mask) {
+#ifdef SIMPLEMATH_X86
+    return run_parallel(cpu_has_avx2() ? sqrt_range_avx2 : sqrt_range, out, in,
+                        n, mask);
+#else
+    return run_parallel(sqrt_range, out, in, n, mask);
+#endif
+}
+
+size_t log10_batch(double* out, const double* in, size_t n, unsigned char* mask) {
+#ifdef SIMPLEMATH_X86
+    return run_parallel(cpu_has_avx2() ? log10_range_avx2 : log10_range, out,
+                        in, n, mask);
+#else
+    return run_parallel(log10_range, out, in, n, mask);
+#endif
+}
@@ -1,7 +1,19 @@
 #include <math.h>
 #include <stdio.h>
 
-int main() {
+#include "batch_io.h"
+#include "simplemath.h"
+
+// Batch kernel: negative inputs produce NaN and count as domain errors
+static size_t sqrt_kernel(double* out, const double* in, size_t n) {
+    return sqrt_batch(out, in, n, NULL);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return batch_main(argc, argv, "sqrt", sqrt_kernel);
+    }
+
     double number, result;
 
     printf("Enter a number to find its square root: ");
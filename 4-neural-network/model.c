@@ -0,0 +1,190 @@
+#include "model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nn/operator.h"
+
+/**
+ * Create randomly initialized weights for the simple CNN
+ * @return Pointer to newly created weights, NULL on failure
+ */
+SimpleCnnWeights* create_simple_cnn_weights(void) {
+    SimpleCnnWeights* weights = (SimpleCnnWeights*)calloc(1, sizeof(SimpleCnnWeights));
+    if (!weights) {
+        fprintf(stderr, "Error: Failed to allocate memory for CNN weights\n");
+        return NULL;
+    }
+
+    weights->conv1_weights = create_tensor(3, 3, 4, true);
+    weights->conv1_bias = create_tensor(4, 1, 1, true);
+    weights->conv2_weights = create_tensor(3, 3, 8, true);
+    weights->conv2_bias = create_tensor(8, 1, 1, true);
+    weights->fc_weights = create_tensor(SIMPLE_CNN_OUTPUT_SIZE, 128, 1, true);
+    weights->fc_bias = create_tensor(SIMPLE_CNN_OUTPUT_SIZE, 1, 1, true);
+
+    if (!weights->conv1_weights || !weights->conv1_bias ||
+        !weights->conv2_weights || !weights->conv2_bias ||
+        !weights->fc_weights || !weights->fc_bias) {
+        free_simple_cnn_weights(&weights);
+        return NULL;
+    }
+
+    return weights;
+}
+
+/**
+ * Replace one tensor with a copy in another storage type
+ * @return 0 on success, -1 on failure (tensor left unchanged)
+ */
+static int convert_in_place(Tensor** tensor, TensorDType dtype) {
+    if ((*tensor)->dtype == dtype) {
+        return 0;
+    }
+    Tensor* converted = convert_tensor(*tensor, dtype);
+    if (!converted) {
+        return -1;
+    }
+    free_tensor(tensor);
+    *tensor = converted;
+    return 0;
+}
+
+/**
+ * Change the storage type of the CNN weights (fp16/bf16 halve their size)
+ * @param weights Weights to convert
+ * @param dtype New storage type
+ * @return 0 on success, -1 on failure
+ */
+int convert_simple_cnn_weights(SimpleCnnWeights* weights, TensorDType dtype) {
+    if (!weights) {
+        fprintf(stderr, "Error: Invalid weights for conversion\n");
+        return -1;
+    }
+
+    if (convert_in_place(&weights->conv1_weights, dtype) != 0 ||
+        convert_in_place(&weights->conv1_bias, dtype) != 0 ||
+        convert_in_place(&weights->conv2_weights, dtype) != 0 ||
+        convert_in_place(&weights->conv2_bias, dtype) != 0 ||
+        convert_in_place(&weights->fc_weights, dtype) != 0 ||
+        convert_in_place(&weights->fc_bias, dtype) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Free CNN weights and set pointer to NULL
+ * @param weights Pointer to weights pointer
+ */
+void free_simple_cnn_weights(SimpleCnnWeights** weights) {
+    if (weights && *weights) {
+        free_tensor(&(*weights)->conv1_weights);
+        free_tensor(&(*weights)->conv1_bias);
+        free_tensor(&(*weights)->conv2_weights);
+        free_tensor(&(*weights)->conv2_bias);
+        free_tensor(&(*weights)->fc_weights);
+        free_tensor(&(*weights)->fc_bias);
+        free(*weights);
+        *weights = NULL;
+    }
+}
+
+/**
+ * Create activation buffers for one inference thread
+ * @param dtype Storage type of the activations (fp16/bf16 halve their size)
+ * @return Pointer to newly created workspace, NULL on failure
+ */
+SimpleCnnWorkspace* create_simple_cnn_workspace(TensorDType dtype) {
+    SimpleCnnWorkspace* workspace =
+        (SimpleCnnWorkspace*)calloc(1, sizeof(SimpleCnnWorkspace));
+    if (!workspace) {
+        fprintf(stderr, "Error: Failed to allocate memory for CNN workspace\n");
+        return NULL;
+    }
+
+    workspace->conv1_output = create_tensor_dtype(16, 16, 4, dtype, false);
+    workspace->pool1_output = create_tensor_dtype(8, 8, 4, dtype, false);
+    workspace->conv2_output = create_tensor_dtype(8, 8, 8, dtype, false);
+    workspace->pool2_output = create_tensor_dtype(4, 4, 8, dtype, false);
+    workspace->flatten_input = create_tensor_dtype(128, 1, 1, dtype, false);
+
+    if (!workspace->conv1_output || !workspace->pool1_output ||
+        !workspace->conv2_output || !workspace->pool2_output ||
+        !workspace->flatten_input) {
+        free_simple_cnn_workspace(&workspace);
+        return NULL;
+    }
+
+    return workspace;
+}
+
+/**
+ * Free CNN workspace and set pointer to NULL
+ * @param workspace Pointer to workspace pointer
+ */
+void free_simple_cnn_workspace(SimpleCnnWorkspace** workspace) {
+    if (workspace && *workspace) {
+        free_tensor(&(*workspace)->conv1_output);
+        free_tensor(&(*workspace)->pool1_output);
+        free_tensor(&(*workspace)->conv2_output);
+        free_tensor(&(*workspace)->pool2_output);
+        free_tensor(&(*workspace)->flatten_input);
+        free(*workspace);
+        *workspace = NULL;
+    }
+}
+
+/**
+ * Run the simple CNN on one input
+ * @param output Output tensor (10x1x1)
+ * @param input Input tensor (16x16x1)
+ * @param weights Shared layer parameters (not modified)
+ * @param workspace Activation buffers owned by the calling thread
+ */
+void simple_cnn_forward(Tensor* output, Tensor* input,
+                        const SimpleCnnWeights* weights,
+                        SimpleCnnWorkspace* workspace) {
+    if (!output || !input || !weights || !workspace) {
+        fprintf(stderr, "Error: Invalid arguments for simple_cnn_forward\n");
+        return;
+    }
+
+    // ===== Layer 1: Convolution (16x16x1 -> 16x16x4) =====
+    conv2d(workspace->conv1_output, input, weights->conv1_weights,
+           weights->conv1_bias);
+    relu(workspace->conv1_output, workspace->conv1_output);
+
+    // ===== Layer 2: Max Pooling (16x16x4 -> 8x8x4) =====
+    maxpool2d(workspace->pool1_output, workspace->conv1_output, 2);
+
+    // ===== Layer 3: Convolution (8x8x4 -> 8x8x8) =====
+    conv2d(workspace->conv2_output, workspace->pool1_output,
+           weights->conv2_weights, weights->conv2_bias);
+    relu(workspace->conv2_output, workspace->conv2_output);
+
+    // ===== Layer 4: Max Pooling (8x8x8 -> 4x4x8) =====
+    maxpool2d(workspace->pool2_output, workspace->conv2_output, 2);
+
+    // ===== Layer 5: Flatten and Fully Connected (4x4x8=128 -> 10) =====
+    flatten(workspace->flatten_input, workspace->pool2_output);
+    linear(output, workspace->flatten_input, weights->fc_weights,
+           weights->fc_bias);
+}
+
+/**
+ * Run the simple CNN once with freshly initialized random weights
+ * @param output Output tensor (10x1x1)
+ * @param input Input tensor (16x16x1)
+ */
+void simple_cnn(Tensor* output, Tensor* input) {
+    SimpleCnnWeights* weights = create_simple_cnn_weights();
+    SimpleCnnWorkspace* workspace = create_simple_cnn_workspace(TENSOR_F32);
+
+    if (weights && workspace) {
+        simple_cnn_forward(output, input, weights, workspace);
+    }
+
+    free_simple_cnn_workspace(&workspace);
+    free_simple_cnn_weights(&weights);
+}
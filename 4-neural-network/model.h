@@ -0,0 +1,51 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include "nn/tensor.h"
+
+/**
+ * Simple CNN
+ * Architecture:
+ * Input(16x16x1) -> Conv1(16x16x4) -> Pool1(8x8x4) -> Conv2(8x8x8) ->
+ * Pool2(4x4x8) -> FC3(10)
+ */
+#define SIMPLE_CNN_INPUT_WIDTH 16
+#define SIMPLE_CNN_INPUT_HEIGHT 16
+#define SIMPLE_CNN_INPUT_CHANNELS 1
+#define SIMPLE_CNN_INPUT_SIZE \
+    (SIMPLE_CNN_INPUT_WIDTH * SIMPLE_CNN_INPUT_HEIGHT * SIMPLE_CNN_INPUT_CHANNELS)
+#define SIMPLE_CNN_OUTPUT_SIZE 10
+
+// Layer parameters; read-only once created, so one copy can be shared by
+// any number of threads
+typedef struct SimpleCnnWeights {
+    Tensor* conv1_weights;
+    Tensor* conv1_bias;
+    Tensor* conv2_weights;
+    Tensor* conv2_bias;
+    Tensor* fc_weights;
+    Tensor* fc_bias;
+} SimpleCnnWeights;
+
+// Intermediate activations; each thread running inference needs its own.
+// They may be stored as fp16/bf16; every layer still accumulates in fp32
+typedef struct SimpleCnnWorkspace {
+    Tensor* conv1_output;
+    Tensor* pool1_output;
+    Tensor* conv2_output;
+    Tensor* pool2_output;
+    Tensor* flatten_input;
+} SimpleCnnWorkspace;
+
+SimpleCnnWeights* create_simple_cnn_weights(void);
+int convert_simple_cnn_weights(SimpleCnnWeights* weights, TensorDType dtype);
+void free_simple_cnn_weights(SimpleCnnWeights** weights);
+SimpleCnnWorkspace* create_simple_cnn_workspace(TensorDType dtype);
+void free_simple_cnn_workspace(SimpleCnnWorkspace** workspace);
+
+void simple_cnn_forward(Tensor* output, Tensor* input,
+                        const SimpleCnnWeights* weights,
+                        SimpleCnnWorkspace* workspace);
+void simple_cnn(Tensor* output, Tensor* input);
+
+#endif // MODEL_H
@@ -0,0 +1,19 @@
+#ifndef NN_HALF_H
+#define NN_HALF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scalar conversions (round to nearest even)
+float fp16_to_fp32(uint16_t value);
+uint16_t fp32_to_fp16(float value);
+float bf16_to_fp32(uint16_t value);
+uint16_t fp32_to_bf16(float value);
+
+// Array conversions (F16C/AVX2 on x86 CPUs that support them, scalar otherwise)
+void fp16_to_fp32_array(float* dst, const uint16_t* src, size_t count);
+void fp32_to_fp16_array(uint16_t* dst, const float* src, size_t count);
+void bf16_to_fp32_array(float* dst, const uint16_t* src, size_t count);
+void fp32_to_bf16_array(uint16_t* dst, const float* src, size_t count);
+
+#endif // NN_HALF_H
@@ -3,19 +3,40 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+// Element storage type; 16-bit types are converted to fp32 for arithmetic
+typedef enum TensorDType {
+    TENSOR_F32 = 0,
+    TENSOR_F16,   // IEEE 754 half precision
+    TENSOR_BF16,  // bfloat16
+} TensorDType;
 
 typedef struct Tensor {
-    float* data;
+    float* data;        // fp32 storage, NULL unless dtype == TENSOR_F32
     size_t width;
     size_t height;
     size_t channels;
+    TensorDType dtype;
+    uint16_t* data16;   // fp16/bf16 storage, NULL when dtype == TENSOR_F32
 } Tensor;
 
 Tensor* create_tensor(size_t width, size_t height, size_t channels, bool random_init);
+Tensor* create_tensor_dtype(size_t width, size_t height, size_t channels,
+                            TensorDType dtype, bool random_init);
+Tensor* convert_tensor(const Tensor* tensor, TensorDType dtype);
 void free_tensor(Tensor** tensor);
 void random_init_tensor(Tensor* tensor);
 float get_tensor_element(Tensor* tensor, size_t w, size_t h, size_t c);
 void set_tensor_element(Tensor* tensor, size_t w, size_t h, size_t c, float value);
 void print_tensor(const Tensor* tensor);
 
+bool tensor_has_data(const Tensor* tensor);
+size_t tensor_size(const Tensor* tensor);
+const char* tensor_dtype_name(TensorDType dtype);
+float get_tensor_value(const Tensor* tensor, size_t index);
+void set_tensor_value(Tensor* tensor, size_t index, float value);
+void get_tensor_values(const Tensor* tensor, size_t offset, size_t count, float* dst);
+void set_tensor_values(Tensor* tensor, size_t offset, size_t count, const float* src);
+
 #endif // NN_TENSOR_H
@@ -0,0 +1,214 @@
+#include "nn/half.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NN_F16C_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+static uint32_t float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Convert an IEEE half-precision value to single precision (exact)
+ * @param value fp16 bit pattern
+ * @return Converted value
+ */
+float fp16_to_fp32(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+
+    if (exponent == 0x1F) {
+        // Infinity or NaN (payload kept, quiet bit set)
+        return bits_to_float(sign | 0x7F800000 | (mantissa << 13) |
+                             (mantissa ? 0x00400000 : 0));
+    }
+    if (exponent == 0) {
+        // Zero or subnormal: mantissa * 2^-24
+        float magnitude = (float)mantissa * 5.9604644775390625e-8f;
+        return bits_to_float(sign | float_to_bits(magnitude));
+    }
+    return bits_to_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/**
+ * Convert a single-precision value to IEEE half precision
+ * Rounds to nearest even; overflow becomes infinity
+ * @param value Value to convert
+ * @return fp16 bit pattern
+ */
+uint16_t fp32_to_fp16(float value) {
+    uint32_t bits = float_to_bits(value);
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude >= 0x7F800000) {
+        // Infinity or NaN (NaN payload truncated, quiet bit set)
+        return sign | (magnitude > 0x7F800000 ? 0x7E00 | ((magnitude >> 13) & 0x3FF)
+                                              : 0x7C00);
+    }
+    if (magnitude >= 0x477FF000) {
+        return sign | 0x7C00;  // >= 65520 rounds to infinity
+    }
+    if (magnitude < 0x38800000) {
+        // Result is subnormal or zero: adding 0.5 pushes the value into a
+        // float whose low mantissa bits are the rounded fp16 mantissa
+        float rounded = bits_to_float(magnitude) + 0.5f;
+        return sign | (uint16_t)(float_to_bits(rounded) - 0x3F000000);
+    }
+
+    // Normal result: rebias the exponent and round the dropped 13 bits
+    uint32_t odd = (magnitude >> 13) & 1;
+    magnitude += 0xC8000FFF + odd;  // (15 - 127) << 23, plus rounding bias
+    return sign | (uint16_t)(magnitude >> 13);
+}
+
+/**
+ * Convert a bfloat16 value to single precision (exact)
+ * @param value bf16 bit pattern
+ * @return Converted value
+ */
+float bf16_to_fp32(uint16_t value) {
+    return bits_to_float((uint32_t)value << 16);
+}
+
+/**
+ * Convert a single-precision value to bfloat16
+ * Rounds to nearest even; NaN stays NaN
+ * @param value Value to convert
+ * @return bf16 bit pattern
+ */
+uint16_t fp32_to_bf16(float value) {
+    uint32_t bits = float_to_bits(value);
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return (uint16_t)((bits >> 16) | 0x0040);  // keep NaN quiet
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return (uint16_t)(bits >> 16);
+}
+
+#ifdef NN_F16C_DISPATCH
+static int cpu_has_f16c(void) {
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+
+static int cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+// bf16 -> fp32 is a 16-bit shift; AVX2 widens and shifts eight at a time
+__attribute__((target("avx2"))) static void bf16_to_fp32_avx2(
+    float* dst, const uint16_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm_loadu_si128((const __m128i*)(const void*)(src + i));
+        __m256i wide = _mm256_slli_epi32(_mm256_cvtepu16_epi32(half), 16);
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(wide));
+    }
+    for (; i < count; i++) {
+        dst[i] = bf16_to_fp32(src[i]);
+    }
+}
+
+__attribute__((target("avx,f16c"))) static void fp16_to_fp32_f16c(
+    float* dst, const uint16_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm_loadu_si128((const __m128i*)(const void*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+    }
+    for (; i < count; i++) {
+        dst[i] = fp16_to_fp32(src[i]);
+    }
+}
+
+__attribute__((target("avx,f16c"))) static void fp32_to_fp16_f16c(
+    uint16_t* dst, const float* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+                                       _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(void*)(dst + i), half);
+    }
+    for (; i < count; i++) {
+        dst[i] = fp32_to_fp16(src[i]);
+    }
+}
+#endif
+
+/**
+ * Convert an array of fp16 values to single precision
+ * @param dst Output array
+ * @param src Input fp16 bit patterns
+ * @param count Number of elements
+ */
+void fp16_to_fp32_array(float* dst, const uint16_t* src, size_t count) {
+#ifdef NN_F16C_DISPATCH
+    if (cpu_has_f16c()) {
+        fp16_to_fp32_f16c(dst, src, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = fp16_to_fp32(src[i]);
+    }
+}
+
+/**
+ * Convert an array of single-precision values to fp16
+ * @param dst Output fp16 bit patterns
+ * @param src Input array
+ * @param count Number of elements
+ */
+void fp32_to_fp16_array(uint16_t* dst, const float* src, size_t count) {
+#ifdef NN_F16C_DISPATCH
+    if (cpu_has_f16c()) {
+        fp32_to_fp16_f16c(dst, src, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = fp32_to_fp16(src[i]);
+    }
+}
+
+/**
+ * Convert an array of bf16 values to single precision
+ * @param dst Output array
+ * @param src Input bf16 bit patterns
+ * @param count Number of elements
+ */
+void bf16_to_fp32_array(float* dst, const uint16_t* src, size_t count) {
+#ifdef NN_F16C_DISPATCH
+    if (cpu_has_avx2()) {
+        bf16_to_fp32_avx2(dst, src, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = bf16_to_fp32(src[i]);
+    }
+}
+
+/**
+ * Convert an array of single-precision values to bf16
+ * @param dst Output bf16 bit patterns
+ * @param src Input array
+ * @param count Number of elements
+ */
+void fp32_to_bf16_array(uint16_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = fp32_to_bf16(src[i]);
+    }
+}
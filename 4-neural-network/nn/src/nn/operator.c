@@ -3,18 +3,59 @@
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "nn/tensor.h"
 
+// Elements of a 16-bit row converted to fp32 at a time
+#define CONVERT_BLOCK 256
+
+// fp32 scratch kept on the stack for 16-bit tensors; only tensors larger
+// than this (none in the example model) fall back to the heap, so serving
+// threads do not allocate per layer
+#define SCRATCH_FLOATS 2048
+
+// With NN_MULTIVERSION the hot kernels are compiled once per ISA and the
+// dynamic loader picks the best clone for the running CPU (GNU ifunc)
+#if defined(NN_MULTIVERSION) && defined(__GNUC__) && defined(__x86_64__) && \
+    defined(__linux__)
+#define NN_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define NN_KERNEL
+#endif
+
+/**
+ * Get fp32 scratch space, preferring the caller's stack block
+ * @param stack_block Caller's array of SCRATCH_FLOATS floats
+ * @param count Number of floats needed
+ * @return stack_block, a heap buffer, or NULL if the allocation failed
+ */
+static float* acquire_scratch(float* stack_block, size_t count) {
+    if (count <= SCRATCH_FLOATS) {
+        return stack_block;
+    }
+    return (float*)malloc(count * sizeof(float));
+}
+
+static void release_scratch(float* scratch, float* stack_block) {
+    if (scratch != stack_block) {
+        free(scratch);
+    }
+}
+
 /**
  * 2D Convolution operation
+ * Tensors may use any storage type; a 16-bit input is converted to fp32 once
+ * per call and each output channel's kernel once per channel, and products
+ * are accumulated in fp32
  * @param output Output tensor
  * @param input Input tensor
  * @param weights Convolution weights (kernel)
  * @param bias Bias tensor (can be NULL)
  */
-void conv2d(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
-    if (!output || !input || !weights) {
+NN_KERNEL void conv2d(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
+    if (!tensor_has_data(output) || !tensor_has_data(input) ||
+        !tensor_has_data(weights)) {
         fprintf(stderr, "Error: Invalid tensors for conv2d operation\n");
         return;
     }
@@ -23,15 +64,74 @@ void conv2d(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
     // kernel_width] For simplicity, assume square kernels and same padding
     size_t kernel_size = weights->height;  // Assume square kernel
     size_t pad = kernel_size / 2;          // Same padding
+    size_t kernel_plane = weights->width * weights->height;
+
+    // Kernels are read through raw pointers below, so every output channel
+    // needs its own kernel and every kernel row must be kernel_size wide
+    if (weights->channels < output->channels || weights->width < kernel_size) {
+        fprintf(stderr,
+                "Error: Weight tensor (%zux%zux%zu) does not cover %zu output "
+                "channels for conv2d\n",
+                weights->width, weights->height, weights->channels,
+                output->channels);
+        return;
+    }
+    size_t output_plane = output->width * output->height;
+
+    // fp32 tensors are used in place; 16-bit ones go through fp32 scratch
+    size_t scratch_size = 0;
+    if (input->dtype != TENSOR_F32) {
+        scratch_size += tensor_size(input);
+    }
+    if (weights->dtype != TENSOR_F32) {
+        scratch_size += kernel_plane;
+    }
+    if (output->dtype != TENSOR_F32) {
+        scratch_size += output_plane;
+    }
+    float stack_block[SCRATCH_FLOATS];
+    float* scratch = acquire_scratch(stack_block, scratch_size);
+    if (!scratch) {
+        fprintf(stderr, "Error: Failed to allocate memory for conv2d\n");
+        return;
+    }
+
+    float* next = scratch;
+    const float* input_data = input->data;
+    if (input->dtype != TENSOR_F32) {
+        get_tensor_values(input, 0, tensor_size(input), next);
+        input_data = next;
+        next += tensor_size(input);
+    }
+    float* kernel_block = NULL;
+    if (weights->dtype != TENSOR_F32) {
+        kernel_block = next;
+        next += kernel_plane;
+    }
+    float* output_block = output->dtype != TENSOR_F32 ? next : NULL;
 
     // Perform convolution
     for (size_t out_c = 0; out_c < output->channels; out_c++) {
+        const float* kernel = kernel_block;
+        if (kernel_block) {
+            get_tensor_values(weights, out_c * kernel_plane, kernel_plane,
+                              kernel_block);
+        }
+        else {
+            kernel = weights->data + out_c * kernel_plane;
+        }
+        float* out = output_block ? output_block : output->data + out_c * output_plane;
+        bool has_bias = tensor_has_data(bias);
+        float bias_val = has_bias ? get_tensor_value(bias, out_c) : 0.0f;
+
         for (size_t out_h = 0; out_h < output->height; out_h++) {
             for (size_t out_w = 0; out_w < output->width; out_w++) {
                 float sum = 0.0f;
 
                 // Apply kernel
                 for (size_t in_c = 0; in_c < input->channels; in_c++) {
+                    const float* plane =
+                        input_data + in_c * input->width * input->height;
                     for (size_t k_h = 0; k_h < kernel_size; k_h++) {
                         for (size_t k_w = 0; k_w < kernel_size; k_w++) {
                             // Calculate input position with padding
@@ -42,9 +142,9 @@ void conv2d(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
                             if (in_h >= 0 && in_h < (int)input->height &&
                                 in_w >= 0 && in_w < (int)input->width) {
                                 float input_val =
-                                    get_tensor_element(input, in_w, in_h, in_c);
-                                float weight_val = get_tensor_element(
-                                    weights, k_w, k_h, out_c);
+                                    plane[(size_t)in_h * input->width + (size_t)in_w];
+                                float weight_val =
+                                    kernel[k_h * weights->width + k_w];
                                 sum += input_val * weight_val;
                             }
                         }
@@ -52,25 +152,35 @@ void conv2d(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
                 }
 
                 // Add bias if provided
-                if (bias && bias->data) {
-                    sum += bias->data[out_c];
+                if (has_bias) {
+                    sum += bias_val;
                 }
-
-                set_tensor_element(output, out_w, out_h, out_c, sum);
+                out[out_h * output->width + out_w] = sum;
             }
         }
+
+        if (output_block) {
+            set_tensor_values(output, out_c * output_plane, output_plane,
+                              output_block);
+        }
     }
+
+    release_scratch(scratch, stack_block);
 }
 
 /**
  * Linear (fully connected) operation
+ * Each weight row is read a block at a time (fp16/bf16 blocks are converted
+ * to fp32 first) and accumulated into eight fp32 partial sums, so every
+ * storage type sums in the same order
  * @param output Output tensor
  * @param input Input tensor (flattened)
  * @param weights Weight matrix
  * @param bias Bias vector (can be NULL)
  */
-void linear(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
-    if (!output || !input || !weights) {
+NN_KERNEL void linear(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
+    if (!tensor_has_data(output) || !tensor_has_data(input) ||
+        !tensor_has_data(weights)) {
         fprintf(stderr, "Error: Invalid tensors for linear operation\n");
         return;
     }
@@ -79,21 +189,64 @@ void linear(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
     size_t input_size = input->width * input->height * input->channels;
     size_t output_size = output->width * output->height * output->channels;
 
+    // The input row is reused for every output, so convert it only once
+    const float* input_data = input->data;
+    float stack_block[SCRATCH_FLOATS];
+    float* input_converted = NULL;
+    if (input->dtype != TENSOR_F32) {
+        input_converted = acquire_scratch(stack_block, input_size);
+        if (!input_converted) {
+            fprintf(stderr, "Error: Failed to allocate memory for linear input\n");
+            return;
+        }
+        get_tensor_values(input, 0, input_size, input_converted);
+        input_data = input_converted;
+    }
+
     // Perform matrix multiplication: output = input * weights + bias
+    float converted[CONVERT_BLOCK];
     for (size_t out_idx = 0; out_idx < output_size; out_idx++) {
+        // Eight partial sums keep the dot product from being bound by the
+        // latency of a single fp32 add chain
+        float partial[8] = {0.0f};
+        for (size_t start = 0; start < input_size; start += CONVERT_BLOCK) {
+            size_t count = input_size - start < CONVERT_BLOCK
+                               ? input_size - start
+                               : CONVERT_BLOCK;
+            size_t offset = out_idx * input_size + start;
+            const float* block = converted;
+            if (weights->dtype == TENSOR_F32) {
+                block = weights->data + offset;
+            }
+            else {
+                get_tensor_values(weights, offset, count, converted);
+            }
+            const float* in_block = input_data + start;
+            size_t k = 0;
+            for (; k + 8 <= count; k += 8) {
+                for (size_t j = 0; j < 8; j++) {
+                    partial[j] += in_block[k + j] * block[k + j];
+                }
+            }
+            for (; k < count; k++) {
+                partial[k % 8] += in_block[k] * block[k];
+            }
+        }
         float sum = 0.0f;
-
-        for (size_t in_idx = 0; in_idx < input_size; in_idx++) {
-            sum += input->data[in_idx] *
-                   weights->data[out_idx * input_size + in_idx];
+        for (size_t j = 0; j < 8; j++) {
+            sum += partial[j];
         }
 
         // Add bias if provided
-        if (bias && bias->data) {
-            sum += bias->data[out_idx];
+        if (tensor_has_data(bias)) {
+            sum += get_tensor_value(bias, out_idx);
         }
 
-        output->data[out_idx] = sum;
+        set_tensor_value(output, out_idx, sum);
+    }
+
+    if (input_converted) {
+        release_scratch(input_converted, stack_block);
     }
 }
 
@@ -102,8 +255,8 @@ void linear(Tensor* output, Tensor* input, Tensor* weights, Tensor* bias) {
  * @param output Output tensor
  * @param input Input tensor
  */
-void relu(Tensor* output, Tensor* input) {
-    if (!output || !input) {
+NN_KERNEL void relu(Tensor* output, Tensor* input) {
+    if (!tensor_has_data(output) || !tensor_has_data(input)) {
         fprintf(stderr, "Error: Invalid tensors for relu operation\n");
         return;
     }
@@ -120,8 +273,27 @@ void relu(Tensor* output, Tensor* input) {
     size_t total_elements = input->width * input->height * input->channels;
 
     // Apply ReLU: max(0, x)
-    for (size_t i = 0; i < total_elements; i++) {
-        output->data[i] = fmaxf(0.0f, input->data[i]);
+    if (input->dtype == TENSOR_F32 && output->dtype == TENSOR_F32) {
+        // Plain compare instead of fmaxf so the loop vectorizes in every
+        // clone rather than calling into libm per element
+        for (size_t i = 0; i < total_elements; i++) {
+            float value = input->data[i];
+            output->data[i] = value > 0.0f ? value : 0.0f;
+        }
+        return;
+    }
+
+    // 16-bit storage: convert a block to fp32, clamp, and store it back
+    float block[CONVERT_BLOCK];
+    for (size_t start = 0; start < total_elements; start += CONVERT_BLOCK) {
+        size_t count = total_elements - start < CONVERT_BLOCK
+                           ? total_elements - start
+                           : CONVERT_BLOCK;
+        get_tensor_values(input, start, count, block);
+        for (size_t i = 0; i < count; i++) {
+            block[i] = block[i] > 0.0f ? block[i] : 0.0f;
+        }
+        set_tensor_values(output, start, count, block);
     }
 }
 
@@ -131,8 +303,8 @@ void relu(Tensor* output, Tensor* input) {
  * @param input Input tensor
  * @param pool_size Size of pooling window (assumed square)
  */
-void maxpool2d(Tensor* output, Tensor* input, size_t pool_size) {
-    if (!output || !input) {
+NN_KERNEL void maxpool2d(Tensor* output, Tensor* input, size_t pool_size) {
+    if (!tensor_has_data(output) || !tensor_has_data(input)) {
         fprintf(stderr, "Error: Invalid tensors for maxpool2d operation\n");
         return;
     }
@@ -142,8 +314,41 @@ void maxpool2d(Tensor* output, Tensor* input, size_t pool_size) {
         return;
     }
 
+    // Each output channel pools the input channel with the same index
+    if (input->channels < output->channels) {
+        fprintf(stderr,
+                "Error: Input tensor has fewer channels than output tensor for "
+                "maxpool2d\n");
+        return;
+    }
+
+    // fp32 planes are used in place; 16-bit ones go through fp32 scratch
+    // one channel at a time
+    size_t input_plane = input->width * input->height;
+    size_t output_plane = output->width * output->height;
+    size_t scratch_size = (input->dtype != TENSOR_F32 ? input_plane : 0) +
+                          (output->dtype != TENSOR_F32 ? output_plane : 0);
+    float stack_block[SCRATCH_FLOATS];
+    float* scratch = acquire_scratch(stack_block, scratch_size);
+    if (!scratch) {
+        fprintf(stderr, "Error: Failed to allocate memory for maxpool2d\n");
+        return;
+    }
+    float* input_block = input->dtype != TENSOR_F32 ? scratch : NULL;
+    float* output_block =
+        output->dtype != TENSOR_F32 ? scratch + (input_block ? input_plane : 0) : NULL;
+
     // Perform max pooling
     for (size_t c = 0; c < output->channels; c++) {
+        const float* in = input_block;
+        if (input_block) {
+            get_tensor_values(input, c * input_plane, input_plane, input_block);
+        }
+        else {
+            in = input->data + c * input_plane;
+        }
+        float* out = output_block ? output_block : output->data + c * output_plane;
+
         for (size_t out_h = 0; out_h < output->height; out_h++) {
             for (size_t out_w = 0; out_w < output->width; out_w++) {
                 float max_val = -FLT_MAX;
@@ -156,8 +361,7 @@ void maxpool2d(Tensor* output, Tensor* input, size_t pool_size) {
 
                         // Check bounds
                         if (in_h < input->height && in_w < input->width) {
-                            float val =
-                                get_tensor_element(input, in_w, in_h, c);
+                            float val = in[in_h * input->width + in_w];
                             if (val > max_val) {
                                 max_val = val;
                             }
@@ -165,10 +369,16 @@ void maxpool2d(Tensor* output, Tensor* input, size_t pool_size) {
                     }
                 }
 
-                set_tensor_element(output, out_w, out_h, c, max_val);
+                out[out_h * output->width + out_w] = max_val;
             }
         }
+
+        if (output_block) {
+            set_tensor_values(output, c * output_plane, output_plane, output_block);
+        }
     }
+
+    release_scratch(scratch, stack_block);
 }
 
 /**
@@ -182,7 +392,7 @@ void flatten(Tensor* output, Tensor* input) {
         return;
     }
 
-    if (!output->data || !input->data) {
+    if (!tensor_has_data(output) || !tensor_has_data(input)) {
         fprintf(stderr,
                 "Error: Tensors have NULL data for flatten operation\n");
         return;
@@ -202,8 +412,22 @@ void flatten(Tensor* output, Tensor* input) {
     }
 
     // Copy data from input to output (flattening)
+    if (input->dtype == TENSOR_F32 && output->dtype == TENSOR_F32) {
+        for (size_t i = 0; i < input_total; i++) {
+            output->data[i] = input->data[i];
+        }
+        return;
+    }
+
+    if (input->dtype == output->dtype) {
+        for (size_t i = 0; i < input_total; i++) {
+            output->data16[i] = input->data16[i];
+        }
+        return;
+    }
+
     for (size_t i = 0; i < input_total; i++) {
-        output->data[i] = input->data[i];
+        set_tensor_value(output, i, get_tensor_value(input, i));
     }
 }
 
@@ -214,7 +438,7 @@ void flatten(Tensor* output, Tensor* input) {
 * @param input Input tensor
 */
 void max(float* output, int* index, Tensor* input) {
-   if (!output || !index || !input || !input->data) {
+   if (!output || !index || !tensor_has_data(input)) {
        fprintf(stderr, "Error: Invalid parameters for max operation\n");
        return;
    }
@@ -226,12 +450,13 @@ void max(float* output, int* index, Tensor* input) {
        return;
    }
 
-   float max_val = input->data[0];
+   float max_val = get_tensor_value(input, 0);
    int max_idx = 0;
 
    for (size_t i = 1; i < input_total; i++) {
-       if (input->data[i] > max_val) {
-           max_val = input->data[i];
+       float val = get_tensor_value(input, i);
+       if (val > max_val) {
+           max_val = val;
            max_idx = (int)i;
        }
    }
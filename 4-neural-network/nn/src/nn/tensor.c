@@ -4,22 +4,43 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "nn/half.h"
+
 /**
- * Create a new tensor with specified dimensions
+ * Create a new fp32 tensor with specified dimensions
  * @param width Width of the tensor
  * @param height Height of the tensor
  * @param channels Number of channels
  * @return Pointer to newly created tensor, NULL on failure
  */
 Tensor* create_tensor(size_t width, size_t height, size_t channels, bool random_init) {
+    return create_tensor_dtype(width, height, channels, TENSOR_F32, random_init);
+}
+
+/**
+ * Create a new tensor with specified dimensions and storage type
+ * @param width Width of the tensor
+ * @param height Height of the tensor
+ * @param channels Number of channels
+ * @param dtype Element storage type
+ * @return Pointer to newly created tensor, NULL on failure
+ */
+Tensor* create_tensor_dtype(size_t width, size_t height, size_t channels,
+                            TensorDType dtype, bool random_init) {
     // Validate input dimensions
     if (width == 0 || height == 0 || channels == 0) {
         fprintf(stderr, "Error: Invalid tensor dimensions\n");
         return NULL;
     }
 
+    if (dtype != TENSOR_F32 && dtype != TENSOR_F16 && dtype != TENSOR_BF16) {
+        fprintf(stderr, "Error: Invalid tensor data type\n");
+        return NULL;
+    }
+
     // Allocate memory for tensor structure
     Tensor* tensor = (Tensor*)malloc(sizeof(Tensor));
     if (!tensor) {
@@ -32,11 +53,19 @@ Tensor* create_tensor(size_t width, size_t height, size_t channels, bool random_
     tensor->width = width;
     tensor->height = height;
     tensor->channels = channels;
+    tensor->dtype = dtype;
+    tensor->data = NULL;
+    tensor->data16 = NULL;
 
     // Calculate total size and allocate data array
     size_t total_size = width * height * channels;
-    tensor->data = (float*)calloc(total_size, sizeof(float));
-    if (!tensor->data) {
+    if (dtype == TENSOR_F32) {
+        tensor->data = (float*)calloc(total_size, sizeof(float));
+    }
+    else {
+        tensor->data16 = (uint16_t*)calloc(total_size, sizeof(uint16_t));
+    }
+    if (!tensor_has_data(tensor)) {
         fprintf(stderr, "Error: Failed to allocate memory for tensor data\n");
         free(tensor);
         return NULL;
@@ -49,6 +78,36 @@ Tensor* create_tensor(size_t width, size_t height, size_t channels, bool random_
     return tensor;
 }
 
+/**
+ * Create a copy of a tensor with a different storage type
+ * @param tensor Source tensor
+ * @param dtype Element storage type of the copy
+ * @return Pointer to newly created tensor, NULL on failure
+ */
+Tensor* convert_tensor(const Tensor* tensor, TensorDType dtype) {
+    if (!tensor_has_data(tensor)) {
+        fprintf(stderr, "Error: Invalid tensor for conversion\n");
+        return NULL;
+    }
+
+    Tensor* result = create_tensor_dtype(tensor->width, tensor->height,
+                                         tensor->channels, dtype, false);
+    if (!result) {
+        return NULL;
+    }
+
+    // Convert through fp32 in blocks that stay in L1
+    float block[256];
+    size_t total_elements = tensor_size(tensor);
+    for (size_t i = 0; i < total_elements; i += 256) {
+        size_t count = total_elements - i < 256 ? total_elements - i : 256;
+        get_tensor_values(tensor, i, count, block);
+        set_tensor_values(result, i, count, block);
+    }
+
+    return result;
+}
+
 /**
  * Free tensor memory and set pointer to NULL
  * @param tensor Pointer to tensor pointer
@@ -60,6 +119,10 @@ void free_tensor(Tensor** tensor) {
             free((*tensor)->data);
             (*tensor)->data = NULL;
         }
+        if ((*tensor)->data16) {
+            free((*tensor)->data16);
+            (*tensor)->data16 = NULL;
+        }
 
         // Free tensor structure
         free(*tensor);
@@ -72,7 +135,7 @@ void free_tensor(Tensor** tensor) {
  * @param tensor Pointer to tensor to initialize
  */
 void random_init_tensor(Tensor* tensor) {
-    if (!tensor || !tensor->data) {
+    if (!tensor_has_data(tensor)) {
         fprintf(stderr, "Error: Invalid tensor for random initialization\n");
         return;
     }
@@ -94,7 +157,7 @@ void random_init_tensor(Tensor* tensor) {
     for (size_t i = 0; i < total_elements; i++) {
         // Generate random number between -1 and 1
         float random_val = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-        tensor->data[i] = random_val * scale;
+        set_tensor_value(tensor, i, random_val * scale);
     }
 }
 
@@ -107,10 +170,16 @@ void random_init_tensor(Tensor* tensor) {
  * @return Element value, 0.0f if out of bounds
  */
 float get_tensor_element(Tensor* tensor, size_t w, size_t h, size_t c) {
-    if (!tensor || !tensor->data || w >= tensor->width || h >= tensor->height || c >= tensor->channels) {
+    if (!tensor || w >= tensor->width || h >= tensor->height || c >= tensor->channels) {
         return 0.0f;
     }
-    return tensor->data[c * tensor->width * tensor->height + h * tensor->width + w];
+    size_t index = c * tensor->width * tensor->height + h * tensor->width + w;
+    // data is only set for fp32 tensors, so the common case costs no more
+    // than before 16-bit storage existed (this runs for every conv2d MAC)
+    if (tensor->data) {
+        return tensor->data[index];
+    }
+    return tensor->data16 ? get_tensor_value(tensor, index) : 0.0f;
 }
 
 /**
@@ -122,10 +191,16 @@ float get_tensor_element(Tensor* tensor, size_t w, size_t h, size_t c) {
  * @param value Value to set
  */
 void set_tensor_element(Tensor* tensor, size_t w, size_t h, size_t c, float value) {
-    if (!tensor || !tensor->data || w >= tensor->width || h >= tensor->height || c >= tensor->channels) {
+    if (!tensor || w >= tensor->width || h >= tensor->height || c >= tensor->channels) {
         return;
     }
-    tensor->data[c * tensor->width * tensor->height + h * tensor->width + w] = value;
+    size_t index = c * tensor->width * tensor->height + h * tensor->width + w;
+    if (tensor->data) {
+        tensor->data[index] = value;
+    }
+    else if (tensor->data16) {
+        set_tensor_value(tensor, index, value);
+    }
 }
 
 /**
@@ -138,12 +213,18 @@ void print_tensor(const Tensor* tensor) {
         return;
     }
 
-    if (!tensor->data) {
+    if (!tensor_has_data(tensor)) {
         fprintf(stderr, "Error: Tensor has NULL data\n");
         return;
     }
 
-    printf("Tensor[%zu, %zu, %zu] {\n", tensor->channels, tensor->height, tensor->width);
+    if (tensor->dtype == TENSOR_F32) {
+        printf("Tensor[%zu, %zu, %zu] {\n", tensor->channels, tensor->height, tensor->width);
+    }
+    else {
+        printf("Tensor[%zu, %zu, %zu] %s {\n", tensor->channels, tensor->height,
+               tensor->width, tensor_dtype_name(tensor->dtype));
+    }
 
     // Handle different display strategies based on tensor size
     size_t total_elements = tensor->channels * tensor->height * tensor->width;
@@ -154,12 +235,12 @@ void print_tensor(const Tensor* tensor) {
                tensor->channels, tensor->height, tensor->width, total_elements);
 
         // Calculate statistics
-        float min_val = tensor->data[0];
-        float max_val = tensor->data[0];
+        float min_val = get_tensor_value(tensor, 0);
+        float max_val = min_val;
         float sum = 0.0f;
 
         for (size_t i = 0; i < total_elements; i++) {
-            float val = tensor->data[i];
+            float val = get_tensor_value(tensor, i);
             if (val < min_val) min_val = val;
             if (val > max_val) max_val = val;
             sum += val;
@@ -212,3 +293,125 @@ void print_tensor(const Tensor* tensor) {
 
     printf("}\n");
 }
+
+/**
+ * Check that a tensor exists and has storage for its data type
+ * @param tensor Tensor to check (can be NULL)
+ * @return true if the tensor's elements can be accessed
+ */
+bool tensor_has_data(const Tensor* tensor) {
+    if (!tensor) {
+        return false;
+    }
+    return tensor->dtype == TENSOR_F32 ? tensor->data != NULL : tensor->data16 != NULL;
+}
+
+/**
+ * Number of elements in a tensor
+ * @param tensor Input tensor
+ * @return width * height * channels, 0 for NULL
+ */
+size_t tensor_size(const Tensor* tensor) {
+    return tensor ? tensor->width * tensor->height * tensor->channels : 0;
+}
+
+/**
+ * Human-readable name of a tensor data type
+ * @param dtype Data type
+ * @return "f32", "f16", "bf16" or "unknown"
+ */
+const char* tensor_dtype_name(TensorDType dtype) {
+    switch (dtype) {
+    case TENSOR_F32:
+        return "f32";
+    case TENSOR_F16:
+        return "f16";
+    case TENSOR_BF16:
+        return "bf16";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * Get tensor element at a flat index, converted to fp32
+ * @param tensor Input tensor (must have data)
+ * @param index Flat element index (channel-major, then row, then column)
+ * @return Element value
+ */
+float get_tensor_value(const Tensor* tensor, size_t index) {
+    switch (tensor->dtype) {
+    case TENSOR_F16:
+        return fp16_to_fp32(tensor->data16[index]);
+    case TENSOR_BF16:
+        return bf16_to_fp32(tensor->data16[index]);
+    case TENSOR_F32:
+    default:
+        return tensor->data[index];
+    }
+}
+
+/**
+ * Set tensor element at a flat index, rounding to the tensor's data type
+ * @param tensor Output tensor (must have data)
+ * @param index Flat element index
+ * @param value Value to set
+ */
+void set_tensor_value(Tensor* tensor, size_t index, float value) {
+    switch (tensor->dtype) {
+    case TENSOR_F16:
+        tensor->data16[index] = fp32_to_fp16(value);
+        break;
+    case TENSOR_BF16:
+        tensor->data16[index] = fp32_to_bf16(value);
+        break;
+    case TENSOR_F32:
+    default:
+        tensor->data[index] = value;
+        break;
+    }
+}
+
+/**
+ * Read a run of elements as fp32
+ * @param tensor Input tensor (must have data)
+ * @param offset Flat index of the first element
+ * @param count Number of elements
+ * @param dst Output array of count floats
+ */
+void get_tensor_values(const Tensor* tensor, size_t offset, size_t count, float* dst) {
+    switch (tensor->dtype) {
+    case TENSOR_F16:
+        fp16_to_fp32_array(dst, tensor->data16 + offset, count);
+        break;
+    case TENSOR_BF16:
+        bf16_to_fp32_array(dst, tensor->data16 + offset, count);
+        break;
+    case TENSOR_F32:
+    default:
+        memcpy(dst, tensor->data + offset, count * sizeof(float));
+        break;
+    }
+}
+
+/**
+ * Write a run of fp32 values, rounding to the tensor's data type
+ * @param tensor Output tensor (must have data)
+ * @param offset Flat index of the first element
+ * @param count Number of elements
+ * @param src Input array of count floats
+ */
+void set_tensor_values(Tensor* tensor, size_t offset, size_t count, const float* src) {
+    switch (tensor->dtype) {
+    case TENSOR_F16:
+        fp32_to_fp16_array(tensor->data16 + offset, src, count);
+        break;
+    case TENSOR_BF16:
+        fp32_to_bf16_array(tensor->data16 + offset, src, count);
+        break;
+    case TENSOR_F32:
+    default:
+        memcpy(tensor->data + offset, src, count * sizeof(float));
+        break;
+    }
+}
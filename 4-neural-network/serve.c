@@ -0,0 +1,745 @@
+/**
+ * Pipelined inference driver
+ *
+ * reader --> bounded request ring --> micro-batching workers --> ordered writer
+ *
+ * The reader loads 16x16x1 inputs (text, raw float32 or synthetic) into a
+ * ring of request slots and blocks while the ring is full. By default it is
+ * closed-loop (the next request is admitted as soon as a slot frees up);
+ * with --rate requests arrive open-loop on a fixed or Poisson schedule and
+ * every latency is measured from the scheduled arrival, so time spent
+ * waiting for a full ring counts as queueing. Each worker owns
+ * its activation buffers, shares one read-only copy of the weights, and
+ * claims up to --batch-size consecutive requests, waiting at most
+ * --batch-timeout-us for a batch to fill. The writer emits results in input
+ * order and frees the slots; at exit throughput and latency percentiles are
+ * printed to stderr.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "model.h"
+#include "nn/operator.h"
+#include "nn/tensor.h"
+
+typedef enum InputMode { INPUT_TEXT, INPUT_BINARY, INPUT_RANDOM } InputMode;
+typedef enum ArrivalMode { ARRIVAL_FIXED, ARRIVAL_POISSON } ArrivalMode;
+
+typedef struct ServeConfig {
+    const char* input_path;   // NULL or "-" for stdin
+    InputMode input_mode;
+    size_t random_count;      // requests generated in INPUT_RANDOM mode
+    size_t workers;
+    size_t batch_size;
+    long batch_timeout_us;
+    size_t queue_depth;
+    double rate;              // open-loop arrivals per second, 0 = closed loop
+    ArrivalMode arrival_mode;
+    TensorDType weight_dtype;
+    TensorDType activation_dtype;
+    bool quiet;               // skip per-request output
+} ServeConfig;
+
+typedef struct Request {
+    Tensor* input;
+    Tensor* output;
+    double t_enqueue;         // arrival time, published by the reader
+    double t_start;           // claimed by a worker
+    bool done;
+} Request;
+
+typedef struct Pipeline {
+    const ServeConfig* config;
+    const SimpleCnnWeights* weights;
+    Request* slots;           // ring of queue_depth requests, seq % depth
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;  // reader: a slot was released by the writer
+    pthread_cond_t not_empty; // workers: a request was published
+    pthread_cond_t completed; // writer: a request finished
+
+    size_t read_seq;          // requests published by the reader
+    size_t dispatch_seq;      // requests claimed by workers
+    size_t write_seq;         // requests written and released
+    bool eof;
+    bool failed;
+
+    size_t batches;           // micro-batches dispatched
+} Pipeline;
+
+typedef struct LatencyStats {
+    double* total;            // enqueue -> written, seconds
+    double* queued;           // enqueue -> claimed by a worker, seconds
+    size_t count;
+    size_t capacity;
+} LatencyStats;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void to_timespec(struct timespec* ts, double seconds) {
+    ts->tv_sec = (time_t)seconds;
+    ts->tv_nsec = (long)((seconds - (double)ts->tv_sec) * 1e9);
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// Sleep until the given CLOCK_MONOTONIC time (returns at once if it passed)
+static void sleep_until(double seconds) {
+    struct timespec ts;
+    to_timespec(&ts, seconds);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static uint64_t xorshift64(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options] [FILE]\n", prog);
+    fprintf(stderr, "  FILE                   Inputs, %d floats each (stdin if omitted or -)\n",
+            SIMPLE_CNN_INPUT_SIZE);
+    fprintf(stderr, "  --binary               Read raw float32 inputs instead of text\n");
+    fprintf(stderr, "  --random N             Generate N random inputs instead of reading\n");
+    fprintf(stderr, "  --workers N            Inference threads (default: online CPUs)\n");
+    fprintf(stderr, "  --batch-size N         Max requests per micro-batch (default: 8)\n");
+    fprintf(stderr, "  --batch-timeout-us N   Max wait for a batch to fill (default: 200)\n");
+    fprintf(stderr, "  --queue-depth N        Request ring capacity (default: 256)\n");
+    fprintf(stderr, "  --rate R               Open-loop arrivals at R requests/s (default: closed loop)\n");
+    fprintf(stderr, "  --arrival MODE         Arrival spacing with --rate: poisson or fixed (default: poisson)\n");
+    fprintf(stderr, "  --weight-dtype TYPE    Weight storage: f32, f16 or bf16 (default: f32)\n");
+    fprintf(stderr, "  --activation-dtype TYPE  Activation storage: f32, f16 or bf16 (default: f32)\n");
+    fprintf(stderr, "  --quiet                Do not print per-request results\n");
+}
+
+static bool parse_size(const char* text, size_t* value) {
+    char* end;
+    errno = 0;
+    unsigned long long v = strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || text[0] == '-') {
+        return false;
+    }
+    *value = (size_t)v;
+    return true;
+}
+
+static bool parse_rate(const char* text, double* value) {
+    char* end;
+    errno = 0;
+    double v = strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || !(v > 0.0) || isinf(v)) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+static bool parse_dtype(const char* text, TensorDType* dtype) {
+    if (strcmp(text, "f32") == 0) {
+        *dtype = TENSOR_F32;
+    }
+    else if (strcmp(text, "f16") == 0) {
+        *dtype = TENSOR_F16;
+    }
+    else if (strcmp(text, "bf16") == 0) {
+        *dtype = TENSOR_BF16;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+static int parse_args(ServeConfig* config, int argc, char** argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    config->input_path = NULL;
+    config->input_mode = INPUT_TEXT;
+    config->random_count = 0;
+    config->workers = cpus > 0 ? (size_t)cpus : 1;
+    config->batch_size = 8;
+    config->batch_timeout_us = 200;
+    config->queue_depth = 256;
+    config->rate = 0.0;
+    config->arrival_mode = ARRIVAL_POISSON;
+    config->weight_dtype = TENSOR_F32;
+    config->activation_dtype = TENSOR_F32;
+    config->quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        size_t number = 0;
+        bool takes_value = strcmp(arg, "--random") == 0 ||
+                           strcmp(arg, "--workers") == 0 ||
+                           strcmp(arg, "--batch-size") == 0 ||
+                           strcmp(arg, "--batch-timeout-us") == 0 ||
+                           strcmp(arg, "--queue-depth") == 0;
+
+        if (takes_value) {
+            if (!value || !parse_size(value, &number)) {
+                fprintf(stderr, "Error: %s expects a non-negative integer\n", arg);
+                return -1;
+            }
+            i++;
+        }
+
+        if (strcmp(arg, "--binary") == 0) {
+            config->input_mode = INPUT_BINARY;
+        }
+        else if (strcmp(arg, "--random") == 0) {
+            config->input_mode = INPUT_RANDOM;
+            config->random_count = number;
+        }
+        else if (strcmp(arg, "--workers") == 0) {
+            config->workers = number;
+        }
+        else if (strcmp(arg, "--batch-size") == 0) {
+            config->batch_size = number;
+        }
+        else if (strcmp(arg, "--batch-timeout-us") == 0) {
+            config->batch_timeout_us = (long)number;
+        }
+        else if (strcmp(arg, "--queue-depth") == 0) {
+            config->queue_depth = number;
+        }
+        else if (strcmp(arg, "--rate") == 0) {
+            if (!value || !parse_rate(value, &config->rate)) {
+                fprintf(stderr, "Error: --rate expects a positive number of requests/s\n");
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--arrival") == 0) {
+            if (!value) {
+                fprintf(stderr, "Error: --arrival expects poisson or fixed\n");
+                return -1;
+            }
+            if (strcmp(value, "poisson") == 0) {
+                config->arrival_mode = ARRIVAL_POISSON;
+            }
+            else if (strcmp(value, "fixed") == 0) {
+                config->arrival_mode = ARRIVAL_FIXED;
+            }
+            else {
+                fprintf(stderr, "Error: Unknown arrival mode %s\n", value);
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--weight-dtype") == 0 ||
+                 strcmp(arg, "--activation-dtype") == 0) {
+            if (!value) {
+                fprintf(stderr, "Error: %s expects f32, f16 or bf16\n", arg);
+                return -1;
+            }
+            TensorDType* dtype = strcmp(arg, "--weight-dtype") == 0
+                                     ? &config->weight_dtype
+                                     : &config->activation_dtype;
+            if (!parse_dtype(value, dtype)) {
+                fprintf(stderr, "Error: Unknown tensor type %s\n", value);
+                return -1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--quiet") == 0) {
+            config->quiet = true;
+        }
+        else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        }
+        else if (arg[0] == '-' && arg[1] != '\0') {
+            fprintf(stderr, "Error: Unknown option %s\n", arg);
+            print_usage(argv[0]);
+            return -1;
+        }
+        else if (!config->input_path) {
+            config->input_path = arg;
+        }
+        else {
+            fprintf(stderr, "Error: Only one input file is supported\n");
+            return -1;
+        }
+    }
+
+    if (config->workers == 0 || config->batch_size == 0 ||
+        config->queue_depth == 0) {
+        fprintf(stderr, "Error: --workers, --batch-size and --queue-depth must be positive\n");
+        return -1;
+    }
+    if (config->queue_depth < config->batch_size) {
+        config->queue_depth = config->batch_size;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------ reader */
+
+// Fill one input tensor; returns 1 on success, 0 at clean EOF, -1 on error
+static int read_input(FILE* fp, const ServeConfig* config, float* data,
+                      uint64_t* rng) {
+    switch (config->input_mode) {
+    case INPUT_RANDOM:
+        for (size_t i = 0; i < SIMPLE_CNN_INPUT_SIZE; i++) {
+            // xorshift64: the reader must not contend on rand()'s lock
+            data[i] = (float)(xorshift64(rng) >> 40) / (float)(1 << 24) * 2.0f - 1.0f;
+        }
+        return 1;
+
+    case INPUT_BINARY: {
+        size_t n = fread(data, sizeof(float), SIMPLE_CNN_INPUT_SIZE, fp);
+        if (n == SIMPLE_CNN_INPUT_SIZE) {
+            return 1;
+        }
+        if (n == 0 && feof(fp)) {
+            return 0;
+        }
+        fprintf(stderr, "Error: Truncated binary input (%zu of %d floats)\n", n,
+                SIMPLE_CNN_INPUT_SIZE);
+        return -1;
+    }
+
+    case INPUT_TEXT:
+    default:
+        for (size_t i = 0; i < SIMPLE_CNN_INPUT_SIZE; i++) {
+            int rc = fscanf(fp, "%f", &data[i]);
+            if (rc == 1) {
+                continue;
+            }
+            if (rc == EOF && i == 0) {
+                return 0;
+            }
+            fprintf(stderr, "Error: Invalid or truncated text input (value %zu)\n", i);
+            return -1;
+        }
+        return 1;
+    }
+}
+
+/**
+ * Time between two open-loop arrivals
+ * @return Fixed 1/rate spacing, or an exponential gap with mean 1/rate
+ */
+static double next_arrival_gap(const ServeConfig* config, uint64_t* rng) {
+    if (config->arrival_mode == ARRIVAL_FIXED) {
+        return 1.0 / config->rate;
+    }
+    // Uniform in (0, 1]; never 0, so the log is finite
+    double u = (double)((xorshift64(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    return -log(u) / config->rate;
+}
+
+static void* reader_thread(void* arg) {
+    Pipeline* p = (Pipeline*)arg;
+    const ServeConfig* config = p->config;
+    size_t depth = config->queue_depth;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)time(NULL);
+    uint64_t arrival_rng = rng ^ 0xD1B54A32D192ED03ULL;
+    bool open_loop = config->rate > 0.0;
+    double t_arrival = now_seconds();
+    FILE* fp = NULL;
+
+    if (config->input_mode != INPUT_RANDOM) {
+        if (!config->input_path || strcmp(config->input_path, "-") == 0) {
+            fp = stdin;
+        }
+        else {
+            fp = fopen(config->input_path, config->input_mode == INPUT_BINARY ? "rb" : "r");
+            if (!fp) {
+                fprintf(stderr, "Error: Cannot open %s\n", config->input_path);
+            }
+        }
+    }
+
+    bool failed = config->input_mode != INPUT_RANDOM && !fp;
+    for (size_t seq = 0; !failed; seq++) {
+        if (config->input_mode == INPUT_RANDOM && seq == config->random_count) {
+            break;
+        }
+
+        // Open loop: the request arrives on schedule whether or not there
+        // is room for it; closed loop: it arrives once the reader gets to it
+        if (open_loop) {
+            if (seq > 0) {
+                t_arrival += next_arrival_gap(config, &arrival_rng);
+            }
+            sleep_until(t_arrival);
+        }
+        else {
+            t_arrival = now_seconds();
+        }
+
+        // Wait for the writer to release the slot this request reuses
+        pthread_mutex_lock(&p->lock);
+        while (seq - p->write_seq >= depth) {
+            pthread_cond_wait(&p->not_full, &p->lock);
+        }
+        pthread_mutex_unlock(&p->lock);
+
+        // The slot is owned by the reader until it is published below
+        Request* req = &p->slots[seq % depth];
+        int rc = read_input(fp, config, req->input->data, &rng);
+        if (rc <= 0) {
+            failed = rc < 0;
+            break;
+        }
+        req->done = false;
+        req->t_enqueue = t_arrival;
+
+        pthread_mutex_lock(&p->lock);
+        p->read_seq = seq + 1;
+        pthread_cond_signal(&p->not_empty);
+        pthread_mutex_unlock(&p->lock);
+    }
+
+    if (fp && fp != stdin) {
+        fclose(fp);
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->eof = true;
+    p->failed = failed;
+    pthread_cond_broadcast(&p->not_empty);
+    pthread_cond_broadcast(&p->completed);
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/* ----------------------------------------------------------- workers */
+
+/**
+ * Claim the next micro-batch: up to batch_size consecutive requests, or
+ * fewer once the oldest pending request has waited batch_timeout_us
+ * @return Number of requests claimed starting at *first, 0 when drained
+ */
+static size_t claim_batch(Pipeline* p, size_t* first) {
+    const ServeConfig* config = p->config;
+    size_t claimed = 0;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        size_t pending = p->read_seq - p->dispatch_seq;
+        if (pending > 0) {
+            double deadline = p->slots[p->dispatch_seq % config->queue_depth].t_enqueue +
+                              (double)config->batch_timeout_us * 1e-6;
+            if (pending >= config->batch_size || p->eof || now_seconds() >= deadline) {
+                claimed = pending < config->batch_size ? pending : config->batch_size;
+                break;
+            }
+            struct timespec ts;
+            to_timespec(&ts, deadline);
+            pthread_cond_timedwait(&p->not_empty, &p->lock, &ts);
+            continue;
+        }
+        if (p->eof) {
+            break;
+        }
+        pthread_cond_wait(&p->not_empty, &p->lock);
+    }
+
+    if (claimed > 0) {
+        *first = p->dispatch_seq;
+        p->dispatch_seq += claimed;
+        p->batches++;
+        if (p->read_seq > p->dispatch_seq) {
+            pthread_cond_signal(&p->not_empty);  // more work for another worker
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+    return claimed;
+}
+
+typedef struct Worker {
+    Pipeline* pipeline;
+    SimpleCnnWorkspace* workspace;  // this worker's activation buffers
+    pthread_t thread;
+} Worker;
+
+static void* worker_thread(void* arg) {
+    Worker* worker = (Worker*)arg;
+    Pipeline* p = worker->pipeline;
+    size_t depth = p->config->queue_depth;
+
+    size_t first;
+    size_t count;
+    while ((count = claim_batch(p, &first)) > 0) {
+        double t_start = now_seconds();
+        for (size_t i = 0; i < count; i++) {
+            Request* req = &p->slots[(first + i) % depth];
+            req->t_start = t_start;
+            simple_cnn_forward(req->output, req->input, p->weights,
+                               worker->workspace);
+        }
+
+        pthread_mutex_lock(&p->lock);
+        for (size_t i = 0; i < count; i++) {
+            p->slots[(first + i) % depth].done = true;
+        }
+        pthread_cond_signal(&p->completed);
+        pthread_mutex_unlock(&p->lock);
+    }
+
+    return NULL;
+}
+
+/* ------------------------------------------------------------ writer */
+
+static bool record_latency(LatencyStats* stats, double total, double queued) {
+    if (stats->count == stats->capacity) {
+        size_t capacity = stats->capacity ? stats->capacity * 2 : 4096;
+        double* t = (double*)realloc(stats->total, capacity * sizeof(double));
+        if (!t) {
+            return false;
+        }
+        stats->total = t;
+        double* q = (double*)realloc(stats->queued, capacity * sizeof(double));
+        if (!q) {
+            return false;
+        }
+        stats->queued = q;
+        stats->capacity = capacity;
+    }
+    stats->total[stats->count] = total;
+    stats->queued[stats->count] = queued;
+    stats->count++;
+    return true;
+}
+
+// Write results in input order as they complete; runs on the main thread
+static void run_writer(Pipeline* p, LatencyStats* stats) {
+    size_t depth = p->config->queue_depth;
+    float logits[SIMPLE_CNN_OUTPUT_SIZE];
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        size_t seq = p->write_seq;
+        Request* req = &p->slots[seq % depth];
+        while (!(seq < p->read_seq && req->done) && !(p->eof && seq == p->read_seq)) {
+            pthread_cond_wait(&p->completed, &p->lock);
+        }
+        if (seq == p->read_seq) {
+            break;  // reader finished and everything has been written
+        }
+
+        memcpy(logits, req->output->data, sizeof(logits));
+        double t_enqueue = req->t_enqueue;
+        double t_start = req->t_start;
+        p->write_seq = seq + 1;
+        pthread_cond_signal(&p->not_full);
+        pthread_mutex_unlock(&p->lock);
+
+        size_t best = 0;
+        for (size_t i = 1; i < SIMPLE_CNN_OUTPUT_SIZE; i++) {
+            if (logits[i] > logits[best]) {
+                best = i;
+            }
+        }
+        if (!p->config->quiet) {
+            printf("%zu %zu %.6f\n", seq, best, logits[best]);
+        }
+        double t_done = now_seconds();
+        if (!record_latency(stats, t_done - t_enqueue, t_start - t_enqueue)) {
+            fprintf(stderr, "Error: Failed to allocate latency samples\n");
+        }
+
+        pthread_mutex_lock(&p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+    fflush(stdout);
+}
+
+/* -------------------------------------------------------------- report */
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, size_t n, double pct) {
+    size_t rank = (size_t)(pct / 100.0 * (double)(n - 1) + 0.5);
+    return sorted[rank < n ? rank : n - 1];
+}
+
+static void print_latency(const char* label, double* samples, size_t n) {
+    qsort(samples, n, sizeof(double), compare_double);
+    fprintf(stderr, "  %-8s p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", label,
+            percentile(samples, n, 50) * 1e3, percentile(samples, n, 90) * 1e3,
+            percentile(samples, n, 99) * 1e3, samples[n - 1] * 1e3);
+}
+
+static void print_report(const Pipeline* p, LatencyStats* stats, double elapsed) {
+    const ServeConfig* config = p->config;
+
+    fprintf(stderr, "Requests: %zu  Workers: %zu  Batch size: %zu  "
+                    "Batch timeout: %ld us  Queue depth: %zu  Weights: %s  "
+                    "Activations: %s\n",
+            stats->count, config->workers, config->batch_size,
+            config->batch_timeout_us, config->queue_depth,
+            tensor_dtype_name(config->weight_dtype),
+            tensor_dtype_name(config->activation_dtype));
+    if (config->rate > 0.0) {
+        fprintf(stderr, "Offered load: %.1f requests/s (%s arrivals)\n", config->rate,
+                config->arrival_mode == ARRIVAL_FIXED ? "fixed" : "poisson");
+    }
+    else {
+        fprintf(stderr, "Offered load: closed loop\n");
+    }
+    fprintf(stderr, "Throughput: %.1f requests/s (%.3f s)\n",
+            elapsed > 0 ? (double)stats->count / elapsed : 0.0, elapsed);
+    if (stats->count == 0) {
+        return;
+    }
+    fprintf(stderr, "Mean batch size: %.2f\n",
+            p->batches ? (double)stats->count / (double)p->batches : 0.0);
+    fprintf(stderr, "Latency:\n");
+    print_latency("total", stats->total, stats->count);
+    print_latency("queued", stats->queued, stats->count);
+}
+
+/* ---------------------------------------------------------------- main */
+
+static void free_slots(Request* slots, size_t depth) {
+    if (!slots) {
+        return;
+    }
+    for (size_t i = 0; i < depth; i++) {
+        free_tensor(&slots[i].input);
+        free_tensor(&slots[i].output);
+    }
+    free(slots);
+}
+
+static void free_workers(Worker* workers, size_t count) {
+    if (!workers) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        free_simple_cnn_workspace(&workers[i].workspace);
+    }
+    free(workers);
+}
+
+// Tell every stage that no more requests are coming
+static void close_pipeline(Pipeline* p) {
+    pthread_mutex_lock(&p->lock);
+    p->eof = true;
+    p->failed = true;
+    pthread_cond_broadcast(&p->not_empty);
+    pthread_cond_broadcast(&p->completed);
+    pthread_mutex_unlock(&p->lock);
+}
+
+int main(int argc, char** argv) {
+    ServeConfig config;
+    if (parse_args(&config, argc, argv) != 0) {
+        return 2;
+    }
+
+    SimpleCnnWeights* weights = create_simple_cnn_weights();
+    if (weights && convert_simple_cnn_weights(weights, config.weight_dtype) != 0) {
+        free_simple_cnn_weights(&weights);
+    }
+    Request* slots = (Request*)calloc(config.queue_depth, sizeof(Request));
+    Worker* workers = (Worker*)calloc(config.workers, sizeof(Worker));
+    bool ok = weights && slots && workers;
+    for (size_t i = 0; ok && i < config.queue_depth; i++) {
+        slots[i].input = create_tensor(SIMPLE_CNN_INPUT_WIDTH, SIMPLE_CNN_INPUT_HEIGHT,
+                                       SIMPLE_CNN_INPUT_CHANNELS, false);
+        slots[i].output = create_tensor(SIMPLE_CNN_OUTPUT_SIZE, 1, 1, false);
+        ok = slots[i].input && slots[i].output;
+    }
+    for (size_t i = 0; ok && i < config.workers; i++) {
+        workers[i].workspace = create_simple_cnn_workspace(config.activation_dtype);
+        ok = workers[i].workspace != NULL;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to set up the pipeline\n");
+        free_slots(slots, config.queue_depth);
+        free_workers(workers, config.workers);
+        free_simple_cnn_weights(&weights);
+        return 1;
+    }
+
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.config = &config;
+    p.weights = weights;
+    p.slots = slots;
+
+    // Batch deadlines are CLOCK_MONOTONIC times, see claim_batch()
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.not_full, NULL);
+    pthread_cond_init(&p.not_empty, &cond_attr);
+    pthread_cond_init(&p.completed, NULL);
+    pthread_condattr_destroy(&cond_attr);
+
+    double t_begin = now_seconds();
+
+    size_t started = 0;
+    for (; started < config.workers; started++) {
+        workers[started].pipeline = &p;
+        if (pthread_create(&workers[started].thread, NULL, worker_thread,
+                           &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    pthread_t reader;
+    bool reader_started =
+        started > 0 && pthread_create(&reader, NULL, reader_thread, &p) == 0;
+
+    LatencyStats stats = {0};
+    if (reader_started) {
+        run_writer(&p, &stats);
+        pthread_join(reader, NULL);
+    }
+    else {
+        fprintf(stderr, "Error: Failed to start pipeline threads\n");
+        close_pipeline(&p);
+    }
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    double elapsed = now_seconds() - t_begin;
+    if (reader_started) {
+        print_report(&p, &stats, elapsed);
+    }
+
+    bool failed = p.failed;
+
+    pthread_mutex_destroy(&p.lock);
+    pthread_cond_destroy(&p.not_full);
+    pthread_cond_destroy(&p.not_empty);
+    pthread_cond_destroy(&p.completed);
+    free(stats.total);
+    free(stats.queued);
+    free_slots(slots, config.queue_depth);
+    free_workers(workers, config.workers);
+    free_simple_cnn_weights(&weights);
+    return failed ? 1 : 0;
+}